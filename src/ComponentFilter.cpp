@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "ComponentFilter.hpp"
+
+
+static int32_t find_root(std::vector<int32_t>& parent, int32_t voxel) {
+    // Path halving; parent[i] <= i always holds
+    while (parent[voxel] != voxel) {
+        parent[voxel] = parent[parent[voxel]];
+        voxel = parent[voxel];
+    }
+    return voxel;
+}
+
+static void unite(std::vector<int32_t>& parent, int32_t a, int32_t b) {
+    // Links the larger root under the smaller one
+    a = find_root(parent, a);
+    b = find_root(parent, b);
+    if (a < b) parent[b] = a;
+    else if (b < a) parent[a] = b;
+}
+
+ComponentFilter::ComponentFilter(const Policy policy, const int min_size,
+    const unsigned int num_threads) :
+    policy(policy), min_size(min_size), num_threads(num_threads? num_threads : 1) {}
+
+size_t ComponentFilter::apply(Eigen::Tensor<bool, 3>& space) const {
+    // Labels the 6-connected components of the occupied voxels and
+    // clears the ones rejected by the policy. Returns the number of
+    // removed voxels. The grid is split in up to num_threads slabs
+    // of at least MIN_SLAB_VOXELS along the last (slowest) axis,
+    // labelled in parallel, then the slab borders are merged.
+
+    if (this->policy == Policy::NONE) {
+        return 0;
+    }
+
+    const int64_t nx = space.dimension(0);
+    const int64_t ny = space.dimension(1);
+    const int64_t nz = space.dimension(2);
+    const int64_t plane = nx * ny;
+    const int64_t total = plane * nz;
+
+    if (total > std::numeric_limits<int32_t>::max()) {
+        throw std::runtime_error("Voxel space too large for component labeling");
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    bool* voxels = space.data();
+    std::vector<int32_t> parent(static_cast<size_t>(total));
+
+    const int64_t slabs = std::max<int64_t>(1, std::min({nz,
+        static_cast<int64_t>(this->num_threads), total / MIN_SLAB_VOXELS}));
+    const auto slab_start = [&](int64_t slab) { return nz * slab / slabs; };
+
+    const auto run_slabs = [&](const auto& work) {
+        std::vector<std::thread> workers;
+        for (int64_t slab = 1; slab < slabs; ++slab) {
+            workers.emplace_back(work, slab, slab_start(slab), slab_start(slab + 1));
+        }
+        work(0, slab_start(0), slab_start(1));
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    };
+
+    // Local labeling, every tree stays inside its slab
+    run_slabs([&](int64_t, int64_t z0, int64_t z1) {
+        for (int64_t z = z0; z < z1; ++z) {
+            for (int64_t y = 0; y < ny; ++y) {
+                for (int64_t x = 0; x < nx; ++x) {
+                    const int32_t i = static_cast<int32_t>(x + nx * y + plane * z);
+                    parent[i] = i;
+                    if (!voxels[i]) continue;
+
+                    if (x > 0 && voxels[i - 1]) unite(parent, i, i - 1);
+                    if (y > 0 && voxels[i - nx]) unite(parent, i, i - nx);
+                    if (z > z0 && voxels[i - plane]) unite(parent, i, i - plane);
+                }
+            }
+        }
+    });
+
+    // Merge across slab borders
+    for (int64_t slab = 1; slab < slabs; ++slab) {
+        const int64_t z = slab_start(slab);
+        for (int64_t i = plane * z; i < plane * (z + 1); ++i) {
+            if (voxels[i] && voxels[i - plane]) {
+                unite(parent, static_cast<int32_t>(i), static_cast<int32_t>(i - plane));
+            }
+        }
+    }
+
+    // Flatten: parents precede children, so one ascending pass
+    // leaves every voxel pointing at its root
+    std::vector<int32_t> sizes(static_cast<size_t>(total), 0);
+
+    for (int64_t i = 0; i < total; ++i) {
+        parent[i] = parent[parent[i]];
+        if (voxels[i]) {
+            ++sizes[parent[i]];
+        }
+    }
+
+    int32_t largest = -1;
+    if (this->policy == Policy::KEEP_LARGEST) {
+        largest = static_cast<int32_t>(std::max_element(sizes.begin(),
+            sizes.end()) - sizes.begin());
+    }
+
+    std::vector<size_t> removed(static_cast<size_t>(slabs), 0);
+    run_slabs([&](int64_t slab, int64_t z0, int64_t z1) {
+        size_t count = 0;
+        for (int64_t i = plane * z0; i < plane * z1; ++i) {
+            if (!voxels[i]) continue;
+
+            const bool keep = (this->policy == Policy::KEEP_LARGEST)?
+                parent[i] == largest : sizes[parent[i]] >= this->min_size;
+            if (!keep) {
+                voxels[i] = false;
+                ++count;
+            }
+        }
+        removed[slab] = count;
+    });
+
+    size_t total_removed = 0;
+    for (const size_t count : removed) {
+        total_removed += count;
+    }
+
+    return total_removed;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstddef>
+#include <unsupported/Eigen/CXX11/Tensor>
+
+// Smallest slab worth a labeling thread of its own (a 64^3 grid)
+#define MIN_SLAB_VOXELS (1 << 18)
+
+
+struct ComponentFilter {
+    enum Policy {
+        NONE = 0x0,         // keep every voxel
+        KEEP_LARGEST = 0x1, // keep only the largest component
+        MIN_SIZE = 0x2,     // drop components under min_size voxels
+    };
+
+    Policy policy;
+    int min_size;
+    unsigned int num_threads;
+
+    ComponentFilter(Policy policy = Policy::NONE, int min_size = 0,
+        unsigned int num_threads = 1);
+    size_t apply(Eigen::Tensor<bool, 3>& space) const;
+};
@@ -0,0 +1,397 @@
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <nlohmann/json.hpp>
+#include "Daemon.hpp"
+#include "VoxelModel.hpp"
+
+#ifndef _WIN32
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#define MAX_REQUEST_SIZE 65536
+// Time a client gets to send its request line and to read the response
+#define CLIENT_TIMEOUT_MS 10000
+// Decoded views kept across jobs
+#define VIEW_CACHE_SIZE  1024
+
+
+Daemon::Daemon(const std::filesystem::path& socket_path,
+    const unsigned int num_workers, const int max_resolution) :
+    socket_path(socket_path),
+    num_workers(num_workers? num_workers : 1),
+    max_resolution(max_resolution),
+    running(false) {}
+
+#ifdef _WIN32
+
+void Daemon::start(void) {
+    throw std::runtime_error("Daemon mode requires Unix domain sockets");
+}
+
+#else
+
+static volatile std::sig_atomic_t stop_requested = 0;
+
+static void request_stop(int) {
+    stop_requested = 1;
+}
+
+void Daemon::start(void) {
+    // Listens on the Unix socket and hands every accepted
+    // client to the worker pool until SIGINT or SIGTERM.
+
+    const int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0) {
+        throw std::runtime_error("Cannot create socket: " +
+            std::string(std::strerror(errno)));
+    }
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    const std::string socket_name = socket_path.string();
+
+    if (socket_name.size() >= sizeof(address.sun_path)) {
+        close(server);
+        throw std::runtime_error("Socket path too long: " + socket_name);
+    }
+
+    std::strncpy(address.sun_path, socket_name.c_str(), sizeof(address.sun_path) - 1);
+
+    // Only a socket that nobody answers on is a leftover of a
+    // previous run, anything else at that path is left alone.
+    std::error_code status_error;
+    const auto status = std::filesystem::symlink_status(socket_path, status_error);
+
+    if (std::filesystem::exists(status)) {
+        if (!std::filesystem::is_socket(status)) {
+            close(server);
+            throw std::runtime_error("Not a socket: " + socket_name);
+        }
+
+        const int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        const bool stale = probe >= 0 && connect(probe,
+            reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 &&
+            errno == ECONNREFUSED;
+        if (probe >= 0) close(probe);
+
+        if (!stale) {
+            close(server);
+            throw std::runtime_error("Socket in use: " + socket_name);
+        }
+        std::filesystem::remove(socket_path);
+    }
+
+    if (bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        listen(server, SOMAXCONN) < 0) {
+        const std::string error = std::strerror(errno);
+        close(server);
+        throw std::runtime_error("Cannot listen on " + socket_name + ": " + error);
+    }
+
+    // No SA_RESTART, so accept() returns EINTR on shutdown
+    struct sigaction action{};
+    action.sa_handler = request_stop;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    // Workers inherit a mask with both signals blocked, so they
+    // are always delivered to this thread and interrupt accept()
+    sigset_t stop_signals, previous_mask;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stop_signals, &previous_mask);
+
+    this->running = true;
+    for (unsigned int i = 0; i < num_workers; ++i) {
+        workers.emplace_back(&Daemon::worker_loop, this);
+    }
+    pthread_sigmask(SIG_SETMASK, &previous_mask, nullptr);
+
+    std::cout << "[+] Listening on " << socket_name << " with "
+        << num_workers << " workers" << std::endl;
+
+    while (!stop_requested) {
+        const int client = accept(server, nullptr, nullptr);
+        if (client < 0) {
+            if (errno != EINTR) {
+                std::cerr << "accept: " << std::strerror(errno) << std::endl;
+            }
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            pending_clients.push(client);
+        }
+        queue_condition.notify_one();
+    }
+
+    std::cout << "[+] Shutting down daemon" << std::endl;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        this->running = false;
+    }
+    queue_condition.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    workers.clear();
+    close(server);
+    std::filesystem::remove(socket_path);
+}
+
+void Daemon::worker_loop(void) {
+    // Serves queued clients until the daemon stops and
+    // the queue has been drained.
+
+    while (true) {
+        int client;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_condition.wait(lock, [this] {
+                return !this->running || !pending_clients.empty();
+            });
+
+            if (pending_clients.empty()) {
+                return;
+            }
+            client = pending_clients.front();
+            pending_clients.pop();
+        }
+        this->serve_client(client);
+        close(client);
+    }
+}
+
+void Daemon::serve_client(const int client) {
+    // Reads one newline terminated JSON request and writes
+    // back one newline terminated JSON response. A client that
+    // does not send its line within CLIENT_TIMEOUT_MS gets an
+    // error instead, so it cannot hold a worker indefinitely.
+
+    using clock = std::chrono::steady_clock;
+    const auto deadline = clock::now() + std::chrono::milliseconds(CLIENT_TIMEOUT_MS);
+    std::string request;
+    char buffer[4096];
+    bool timed_out = false;
+
+    while (request.find('\n') == std::string::npos &&
+        request.size() < MAX_REQUEST_SIZE) {
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - clock::now()).count();
+        pollfd readable{client, POLLIN, 0};
+
+        const int ready = (remaining > 0)?
+            poll(&readable, 1, static_cast<int>(remaining)) : 0;
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready == 0) {
+            timed_out = true;
+            break;
+        }
+        if (ready < 0) {
+            break;
+        }
+
+        const ssize_t received = recv(client, buffer, sizeof(buffer), 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            break;
+        }
+        request.append(buffer, static_cast<size_t>(received));
+    }
+
+    std::string response;
+    if (timed_out) {
+        response = nlohmann::json{{"status", "error"},
+            {"message", "Request timed out"}}.dump() + "\n";
+        std::cout << "[+] Job -: error (Request timed out)" << std::endl;
+    } else {
+        response = this->handle_request(request.substr(0, request.find('\n'))) + "\n";
+    }
+
+    // A client that stops reading is dropped after the same delay
+    const timeval send_timeout{CLIENT_TIMEOUT_MS / 1000, (CLIENT_TIMEOUT_MS % 1000) * 1000};
+    setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &send_timeout, sizeof(send_timeout));
+    size_t sent = 0;
+
+    while (sent < response.size()) {
+        const ssize_t written = send(client, response.data() + sent,
+            response.size() - sent, 0);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            break;
+        }
+        sent += static_cast<size_t>(written);
+    }
+}
+
+#endif
+
+std::string Daemon::handle_request(const std::string& request) {
+    // Request:  {"path": str, "resolution": int, "format": "json"|"obj", "output": str,
+    //            "keep_largest": bool, "min_size": int}
+    // Response: {"status": "ok", ...} or {"status": "error", "message": str}
+
+    const auto start = std::chrono::steady_clock::now();
+    nlohmann::json response;
+    std::string job_path;
+
+    try {
+        const nlohmann::json job = nlohmann::json::parse(request);
+
+        if (!job.contains("path") || !job["path"].is_string()) {
+            throw std::runtime_error("Missing field 'path'");
+        }
+
+        const std::filesystem::path path = job["path"].get<std::string>();
+        job_path = path.string();
+        const int resolution = job.value("resolution", 16);
+        const std::string format = job.value("format", std::string("json"));
+
+        if (resolution <= 0) {
+            throw std::runtime_error("Invalid field 'resolution'");
+        }
+        if (resolution > this->max_resolution) {
+            throw std::runtime_error("Field 'resolution' exceeds the limit of " +
+                std::to_string(this->max_resolution));
+        }
+
+        // Single threaded, the jobs already run in parallel
+        ComponentFilter filter;
+        if (job.value("keep_largest", false)) {
+            filter.policy = ComponentFilter::Policy::KEEP_LARGEST;
+        } else if (job.contains("min_size")) {
+            filter.policy = ComponentFilter::Policy::MIN_SIZE;
+            filter.min_size = job["min_size"].get<int>();
+            if (filter.min_size <= 0) {
+                throw std::runtime_error("Invalid field 'min_size'");
+            }
+        }
+        if (format != "json" && format != "obj") {
+            throw std::runtime_error("Invalid field 'format'");
+        }
+        if (format == "obj" && (!job.contains("output") || !job["output"].is_string())) {
+            throw std::runtime_error("Missing field 'output'");
+        }
+
+        const VoxelModel model(path, this->load_views(path), resolution, false, filter, false);
+        response["status"] = "ok";
+
+        if (format == "obj") {
+            const std::filesystem::path output = job["output"].get<std::string>();
+            model.export_obj(output);
+            response["output"] = std::filesystem::absolute(output).string();
+        } else {
+            nlohmann::json cubes = nlohmann::json::array();
+            for (const auto& cube : model.cubes) {
+                cubes.push_back({cube.x, cube.y, cube.z});
+            }
+
+            response["bounds"] = model.bounds;
+            response["cube_dimensions"] = {model.cube_dimensions.x,
+                model.cube_dimensions.y, model.cube_dimensions.z};
+            response["cubes"] = std::move(cubes);
+        }
+    } catch (const std::exception& e) {
+        response = {{"status", "error"}, {"message", e.what()}};
+    }
+
+    // One line per job, the model itself stays quiet
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << "[+] Job " << (job_path.empty()? "-" : job_path) << ": "
+        << (response["status"] == "ok"? std::string("ok") :
+            "error (" + response["message"].get<std::string>() + ")")
+        << " in " << elapsed << " ms" << std::endl;
+    return response.dump();
+}
+
+std::vector<View> Daemon::load_views(const std::filesystem::path& path) {
+    // Same as VoxelModel::load_views, but decoded views are
+    // reused while their camera.json and plane.bmp are unchanged.
+
+    if (!std::filesystem::exists(path))
+        throw std::runtime_error("Not a valid path: " + path.string());
+
+    std::vector<View> views;
+    for (const auto& entry : std::filesystem::directory_iterator(path)) {
+        if (!entry.is_directory()) {
+            continue;
+        }
+
+        try {
+            const auto camera_path = entry.path() / "camera.json";
+            const auto plane_path = entry.path() / "plane.bmp";
+            const auto camera_mtime = std::filesystem::last_write_time(camera_path);
+            const auto plane_mtime = std::filesystem::last_write_time(plane_path);
+            const std::string key = std::filesystem::canonical(entry.path()).string();
+
+            {
+                std::lock_guard<std::mutex> lock(cache_mutex);
+                const auto cached = view_cache.find(key);
+
+                if (cached != view_cache.end() &&
+                    cached->second.camera_mtime == camera_mtime &&
+                    cached->second.plane_mtime == plane_mtime) {
+                    recent_views.splice(recent_views.begin(),
+                        recent_views, cached->second.recent);
+                    views.push_back(cached->second.view);
+                    continue;
+                }
+            }
+
+            View view(entry.path());
+            views.push_back(view);
+            this->cache_view(key, CachedView{camera_mtime, plane_mtime, std::move(view), {}});
+        } catch (const std::exception &e) {
+            std::cerr << "Invalid view: " << entry.path() << ": "
+                << e.what() << std::endl;
+        }
+    }
+    return views;
+}
+
+void Daemon::cache_view(const std::string& key, CachedView cached) {
+    // Inserts or refreshes a view, evicting the least recently
+    // used ones (e.g. of deleted models) past VIEW_CACHE_SIZE.
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    const auto existing = view_cache.find(key);
+
+    if (existing != view_cache.end()) {
+        recent_views.splice(recent_views.begin(), recent_views, existing->second.recent);
+        cached.recent = recent_views.begin();
+        existing->second = std::move(cached);
+        return;
+    }
+
+    recent_views.push_front(key);
+    cached.recent = recent_views.begin();
+    view_cache.emplace(key, std::move(cached));
+
+    while (view_cache.size() > VIEW_CACHE_SIZE) {
+        view_cache.erase(recent_views.back());
+        recent_views.pop_back();
+    }
+}
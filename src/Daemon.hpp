@@ -0,0 +1,48 @@
+#pragma once
+#include <condition_variable>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "View.hpp"
+
+
+struct Daemon {
+
+    struct CachedView {
+        std::filesystem::file_time_type camera_mtime;
+        std::filesystem::file_time_type plane_mtime;
+        View view;
+        std::list<std::string>::iterator recent;
+    };
+
+    const std::filesystem::path socket_path;
+    const unsigned int num_workers;
+    const int max_resolution;
+
+    Daemon(const std::filesystem::path& socket_path, unsigned int num_workers,
+        int max_resolution);
+    void start(void);
+
+private:
+    std::vector<std::thread> workers;
+    std::queue<int> pending_clients;
+    std::mutex queue_mutex;
+    std::condition_variable queue_condition;
+    bool running;
+
+    // Least recently used keys at the back
+    std::unordered_map<std::string, CachedView> view_cache;
+    std::list<std::string> recent_views;
+    std::mutex cache_mutex;
+
+    void worker_loop(void);
+    void serve_client(int client);
+    std::string handle_request(const std::string& request);
+    std::vector<View> load_views(const std::filesystem::path& path);
+    void cache_view(const std::string& key, CachedView cached);
+};
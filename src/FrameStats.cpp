@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include "FrameStats.hpp"
+
+
+FrameStats::FrameStats(const bool keep_history) :
+    frames(0),
+    total_frame_ms(0.0),
+    total_model_ms(0.0),
+    cubes(0),
+    cube_draw_commands(0),
+    keep_history(keep_history) {
+
+    window_frame_ms.reserve(FRAME_WINDOW);
+    window_model_ms.reserve(FRAME_WINDOW);
+}
+
+void FrameStats::record(const double frame_ms, const double model_ms) {
+    // Adds one frame; the window behaves as a ring buffer
+    const size_t slot = frames % FRAME_WINDOW;
+
+    if (window_frame_ms.size() < FRAME_WINDOW) {
+        window_frame_ms.push_back(frame_ms);
+        window_model_ms.push_back(model_ms);
+    } else {
+        window_frame_ms[slot] = frame_ms;
+        window_model_ms[slot] = model_ms;
+    }
+
+    if (keep_history) {
+        history_frame_ms.push_back(frame_ms);
+        history_model_ms.push_back(model_ms);
+    }
+
+    total_frame_ms += frame_ms;
+    total_model_ms += model_ms;
+    ++frames;
+}
+
+double FrameStats::fps(void) const {
+    // Average over the rolling window
+    const double sum = std::accumulate(window_frame_ms.begin(),
+        window_frame_ms.end(), 0.0);
+    return (sum > 0.0)? 1000.0 * window_frame_ms.size() / sum : 0.0;
+}
+
+FrameStats::Summary FrameStats::summarize(std::vector<double> samples) {
+    // Nearest-rank percentiles over a private copy of the samples
+    if (samples.empty()) {
+        return {0.0, 0.0, 0.0, 0.0, 0.0};
+    }
+
+    std::sort(samples.begin(), samples.end());
+    const auto rank = [&](double p) {
+        const size_t index = static_cast<size_t>(std::ceil(p * samples.size()));
+        return samples[std::min(samples.size(), std::max<size_t>(index, 1)) - 1];
+    };
+
+    const double sum = std::accumulate(samples.begin(), samples.end(), 0.0);
+    return {sum / samples.size(), rank(0.50), rank(0.95), rank(0.99), samples.back()};
+}
+
+FrameStats::Summary FrameStats::recent_frames(void) const {
+    return summarize(window_frame_ms);
+}
+
+FrameStats::Summary FrameStats::recent_model(void) const {
+    return summarize(window_model_ms);
+}
+
+nlohmann::json FrameStats::to_json(void) const {
+    // Whole run when the history is kept, else the last window
+    const auto& frame_samples = keep_history? history_frame_ms : window_frame_ms;
+    const auto& model_samples = keep_history? history_model_ms : window_model_ms;
+    const Summary frame = summarize(frame_samples);
+    const Summary model = summarize(model_samples);
+
+    const auto to_object = [](const Summary& summary) {
+        return nlohmann::json{
+            {"mean", summary.mean},
+            {"p50", summary.p50},
+            {"p95", summary.p95},
+            {"p99", summary.p99},
+            {"max", summary.max},
+        };
+    };
+
+    return nlohmann::json{
+        {"frames", frames},
+        {"samples", frame_samples.size()},
+        {"duration_s", total_frame_ms / 1000.0},
+        {"fps", (total_frame_ms > 0.0)? 1000.0 * frames / total_frame_ms : 0.0},
+        {"frame_ms", to_object(frame)},
+        {"draw_model_ms", to_object(model)},
+        {"cube_draw_commands", cube_draw_commands},
+        {"cubes", cubes},
+    };
+}
+
+void FrameStats::write(const std::filesystem::path& output) const {
+    std::ofstream stream(output);
+    if (!stream.is_open()) {
+        throw std::runtime_error("Cannot open output file: " + output.string());
+    }
+    stream << this->to_json().dump(4) << std::endl;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+// Frames used for the on-screen (rolling) statistics
+#define FRAME_WINDOW 240
+
+
+struct FrameStats {
+
+    struct Summary {
+        double mean;
+        double p50;
+        double p95;
+        double p99;
+        double max;
+    };
+
+    size_t frames;
+    double total_frame_ms;
+    double total_model_ms;
+    size_t cubes;
+    // DrawCube/DrawCubeWires calls issued per frame, not GPU
+    // draw calls: raylib batches them into far fewer
+    size_t cube_draw_commands;
+    bool keep_history;
+
+    FrameStats(bool keep_history);
+    void record(double frame_ms, double model_ms);
+    double fps(void) const;
+    Summary recent_frames(void) const;
+    Summary recent_model(void) const;
+    nlohmann::json to_json(void) const;
+    void write(const std::filesystem::path& output) const;
+
+private:
+    // Rolling window for the overlay and, when keep_history
+    // is set, every sample for the final dump.
+    std::vector<double> window_frame_ms;
+    std::vector<double> window_model_ms;
+    std::vector<double> history_frame_ms;
+    std::vector<double> history_model_ms;
+
+    static Summary summarize(std::vector<double> samples);
+};
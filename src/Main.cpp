@@ -5,9 +5,12 @@
 #include <iterator>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <raylib.h>
+#include "Daemon.hpp"
 #include "ModelRender.hpp"
 #include "VoxelModel.hpp"
+#include "VoxelRaycaster.hpp"
 
 
 void print_help(void) {
@@ -16,6 +19,16 @@ void print_help(void) {
         << "    -p, --path <string>    Model path (required)"  << std::endl
         << "    -r, --resolution <int> Voxel space resolution" << std::endl
         << "    -i, --info             Print addditional info" << std::endl
+        << "    -k, --keep-largest     Keep only the largest component" << std::endl
+        << "    -m, --min-size <int>   Drop smaller components"    << std::endl
+        << "    -b, --benchmark <int>  Render N scripted frames and exit" << std::endl
+        << "    -s, --stats <string>   Write frame statistics (JSON)" << std::endl
+        << "    -o, --output <string>  Ray-cast to an image, no window" << std::endl
+        << "    -n, --turntable <int>  Number of turntable images"   << std::endl
+        << "    -w, --width <int>      Ray-cast image width"         << std::endl
+        << "    -d, --daemon <string>  Serve jobs on a Unix socket" << std::endl
+        << "    -j, --jobs <int>       Worker threads (daemon, ray-cast, -k, -m)" << std::endl
+        << "    -x, --max-res <int>    Daemon resolution limit" << std::endl
         << "    -h, --help             Show this help message" << std::endl;
 }
 
@@ -25,6 +38,21 @@ int main(int argc, char* argv[]) {
     int resolution {16};
     bool info {false};
     bool help {false};
+    ComponentFilter filter;
+
+    // Render variables
+    int benchmark_frames {0};
+    std::string stats_path;
+
+    // Ray-caster variables
+    std::string output_path;
+    int turntable {0};
+    int image_width {1280};
+
+    // Daemon variables (jobs is shared with the ray-caster and -k/-m)
+    std::string socket_path;
+    unsigned int jobs {std::thread::hardware_concurrency()};
+    int max_resolution {256};
 
     for (int i = 1; i < argc; ++i) {
         const std::string arg = argv[i];
@@ -37,10 +65,94 @@ int main(int argc, char* argv[]) {
             info = true;
         }
 
+        else if ((arg == "--keep-largest" || arg == "-k")) {
+            filter.policy = ComponentFilter::Policy::KEEP_LARGEST;
+        }
+
+        else if ((arg == "--min-size" || arg == "-m") && (i + 1 < argc)) {
+            try {
+                filter.policy = ComponentFilter::Policy::MIN_SIZE;
+                filter.min_size = std::stoi(argv[i + 1]);
+                if (filter.min_size <= 0) {
+                    throw std::invalid_argument("min-size must be positive");
+                }
+            } catch (const std::exception& e) {
+                throw std::invalid_argument("invalid min-size value");
+            }
+        }
+
         else if ((arg == "--help" || arg == "-h")) {
             help = true;
         }
 
+        else if ((arg == "--stats" || arg == "-s") && (i + 1 < argc)) {
+            stats_path = argv[i + 1];
+        }
+
+        else if ((arg == "--benchmark" || arg == "-b") && (i + 1 < argc)) {
+            try {
+                benchmark_frames = std::stoi(argv[i + 1]);
+                if (benchmark_frames <= 0) {
+                    throw std::invalid_argument("frames must be positive");
+                }
+            } catch (const std::exception& e) {
+                throw std::invalid_argument("invalid benchmark value");
+            }
+        }
+
+        else if ((arg == "--output" || arg == "-o") && (i + 1 < argc)) {
+            output_path = argv[i + 1];
+        }
+
+        else if ((arg == "--turntable" || arg == "-n") && (i + 1 < argc)) {
+            try {
+                turntable = std::stoi(argv[i + 1]);
+                if (turntable <= 0) {
+                    throw std::invalid_argument("turntable must be positive");
+                }
+            } catch (const std::exception& e) {
+                throw std::invalid_argument("invalid turntable value");
+            }
+        }
+
+        else if ((arg == "--width" || arg == "-w") && (i + 1 < argc)) {
+            try {
+                image_width = std::stoi(argv[i + 1]);
+                if (image_width <= 0) {
+                    throw std::invalid_argument("width must be positive");
+                }
+            } catch (const std::exception& e) {
+                throw std::invalid_argument("invalid width value");
+            }
+        }
+
+        else if ((arg == "--daemon" || arg == "-d") && (i + 1 < argc)) {
+            socket_path = argv[i + 1];
+        }
+
+        else if ((arg == "--jobs" || arg == "-j") && (i + 1 < argc)) {
+            try {
+                const int value = std::stoi(argv[i + 1]);
+                if (value <= 0) {
+                    throw std::invalid_argument("jobs must be positive");
+                }
+                jobs = static_cast<unsigned int>(value);
+            } catch (const std::exception& e) {
+                throw std::invalid_argument("invalid jobs value");
+            }
+        }
+
+        else if ((arg == "--max-res" || arg == "-x") && (i + 1 < argc)) {
+            try {
+                max_resolution = std::stoi(argv[i + 1]);
+                if (max_resolution <= 0) {
+                    throw std::invalid_argument("max-res must be positive");
+                }
+            } catch (const std::exception& e) {
+                throw std::invalid_argument("invalid max-res value");
+            }
+        }
+
         else if ((arg == "--resolution" || arg == "-r") && (i + 1 < argc)) {
             try {
                 resolution = std::stoi(argv[i + 1]);
@@ -53,14 +165,43 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    filter.num_threads = jobs;
+
+    if (!help && !socket_path.empty()) {
+        Daemon daemon(socket_path, jobs, max_resolution);
+        daemon.start();
+        return 0;
+    }
+
     if (help || path.empty()) {
         print_help();
         return help ? 0 : 1;
     }
 
+    if (!output_path.empty() && (benchmark_frames > 0 || !stats_path.empty())) {
+        throw std::invalid_argument("benchmark and stats need the window, not output");
+    }
+
     std::cout << "[+] Creating voxel model from " << path << std::endl;
-    VoxelModel model(path, resolution, info);
+    VoxelModel model(path, resolution, info, filter);
     ModelRender render(&model);
+
+    if (!output_path.empty()) {
+        // Headless: reuse the viewer's camera, no window is opened
+        const int image_height = std::max(1, static_cast<int>(
+            image_width * render.aspect_ratio[1] / render.aspect_ratio[0]));
+        VoxelRaycaster raycaster(&model, image_width, image_height, jobs);
+
+        if (turntable > 0) {
+            raycaster.render_turntable(render.camera, turntable, output_path);
+        } else {
+            raycaster.render_to_file(render.camera, output_path);
+        }
+        return 0;
+    }
+
+    render.benchmark_frames = benchmark_frames;
+    render.stats_path = stats_path;
     render.initialize_render_context();
     render.start_render_loop();
     return 0;
@@ -1,3 +1,5 @@
+#include <chrono>
+#include <iostream>
 #include <raylib.h>
 #include <raymath.h>
 #include "ModelRender.hpp"
@@ -18,7 +20,9 @@ ModelRender::ModelRender(const VoxelModel* model):
     width_scale(1),
     height_scale(1),
     text_fontsize(20),
-    box{10, 10, 500, 100} {
+    box{10, 10, 500, 150},
+    stats(false),
+    benchmark_frames(0) {
 
     // Setup the rendering camera details
     this->camera = {
@@ -157,7 +161,31 @@ void ModelRender::zoom(void) {
 }
 
 void ModelRender::draw_help_box(void) const {
-    // Draws the help box with instructions for the user.
+    // Draws the help box with instructions for the user
+    // and the rolling frame statistics.
+
+    const FrameStats::Summary frame = this->stats.recent_frames();
+    const FrameStats::Summary model = this->stats.recent_model();
+    const int padding = this->text_fontsize / 2;
+    const int line = this->text_fontsize + padding / 2;
+    const int x = this->box[0] + padding;
+    int y = this->box[1] + padding;
+
+    DrawRectangle(this->box[0], this->box[1], this->box[2], this->box[3], {0, 0, 0, 160});
+    DrawRectangleLines(this->box[0], this->box[1], this->box[2], this->box[3], GRAY);
+
+    // TextFormat() reuses a few static buffers, draw right away
+    const auto draw_line = [&](const char* text) {
+        DrawText(text, x, y, this->text_fontsize, RAYWHITE);
+        y += line;
+    };
+
+    draw_line(TextFormat("FPS: %.1f", this->stats.fps()));
+    draw_line(TextFormat("Frame: p50 %.2f  p95 %.2f  p99 %.2f ms", frame.p50, frame.p95, frame.p99));
+    draw_line(TextFormat("draw_model: mean %.2f  p95 %.2f ms", model.mean, model.p95));
+    draw_line(TextFormat("Cubes: %zu  Cube draw commands: %zu",
+        this->stats.cubes, this->stats.cube_draw_commands));
+    draw_line("SPACE: rotate  ARROWS: rotate  WHEEL: zoom");
 }
 
 void ModelRender::draw_model(void) const {
@@ -175,19 +203,55 @@ void ModelRender::draw_model(void) const {
 }
 
 void ModelRender::start_render_loop() {
-    // Draws the reconstructed model
+    // Draws the reconstructed model. With benchmark_frames set, the
+    // camera follows the auto-rotate orbit, input is ignored and the
+    // loop ends after that many frames, uncapped by the target FPS.
+
+    using clock = std::chrono::steady_clock;
+    const bool benchmark = this->benchmark_frames > 0;
+    int frame = 0;
+
+    // Each cube is a DrawCube plus a DrawCubeWires
+    this->stats.keep_history = benchmark || !this->stats_path.empty();
+    this->stats.cubes = this->model->cubes.size();
+    this->stats.cube_draw_commands = 2 * this->stats.cubes;
+
+    if (benchmark) {
+        SetTargetFPS(0);
+    }
 
-    while (!WindowShouldClose()) {
-        this->move_camera();
-        this->zoom();
+    auto last_frame = clock::now();
+    while (!WindowShouldClose() && (!benchmark || frame < this->benchmark_frames)) {
+        if (benchmark) {
+            this->rotate_horizontally(true);
+        } else {
+            this->move_camera();
+            this->zoom();
+        }
         BeginDrawing();
 
         ClearBackground({10,10,10,255});
         BeginMode3D(this->camera);
+        const auto model_start = clock::now();
         this->draw_model();
+        const auto model_end = clock::now();
         EndMode3D();
 
         this->draw_help_box();
         EndDrawing();
-    }    
+
+        const auto now = clock::now();
+        this->stats.record(
+            std::chrono::duration<double, std::milli>(now - last_frame).count(),
+            std::chrono::duration<double, std::milli>(model_end - model_start).count());
+        last_frame = now;
+        ++frame;
+    }
+
+    if (!this->stats_path.empty()) {
+        this->stats.write(this->stats_path);
+        std::cout << "[+] Frame statistics written to " << this->stats_path << std::endl;
+    } else if (benchmark) {
+        std::cout << this->stats.to_json().dump(4) << std::endl;
+    }
 }
@@ -1,4 +1,6 @@
+#include <filesystem>
 #include <raylib.h>
+#include "FrameStats.hpp"
 #include "VoxelModel.hpp"
 
 
@@ -23,6 +25,10 @@ struct ModelRender {
     Vector3 horizontal_rotation_axis;
     Vector3 vertical_rotation_axis;
 
+    FrameStats stats;
+    int benchmark_frames;
+    std::filesystem::path stats_path;
+
     ModelRender(const VoxelModel* model);
     void initialize_render_context(void);
     void start_render_loop(void);
@@ -0,0 +1,316 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include "Silhouette.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define BMP_FILE_HEADER 14
+#define BMP_INFO_HEADER 40
+#define BMP_BI_RGB       0
+#define BMP_BI_BITFIELDS 3
+// R, G and B masks right after the 40-byte info header
+#define BMP_MASKS       12
+// Same fixed point BGR to gray weights as OpenCV's imread
+#define GRAY_SHIFT 14
+#define GRAY_B     1868
+#define GRAY_G     9617
+#define GRAY_R     4899
+// (255 << GRAY_SHIFT) - rounding: pixels at or above are white
+#define GRAY_WHITE ((255 << GRAY_SHIFT) - (1 << (GRAY_SHIFT - 1)))
+
+
+// Read-only view of a whole file, unmapped on destruction
+struct MappedFile {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+
+    MappedFile(const std::filesystem::path& path) {
+        file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        LARGE_INTEGER length;
+
+        if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &length)) {
+            this->release();
+            throw std::runtime_error("Cannot open image: " + path.string());
+        }
+
+        size = static_cast<size_t>(length.QuadPart);
+        mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) {
+            data = static_cast<const uint8_t*>(
+                MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        }
+
+        if (!data) {
+            this->release();
+            throw std::runtime_error("Cannot map image: " + path.string());
+        }
+    }
+
+    void release(void) {
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+    }
+#else
+    MappedFile(const std::filesystem::path& path) {
+        const int fd = open(path.c_str(), O_RDONLY);
+        struct stat info;
+
+        if (fd < 0 || fstat(fd, &info) < 0) {
+            if (fd >= 0) close(fd);
+            throw std::runtime_error("Cannot open image: " + path.string());
+        }
+
+        size = static_cast<size_t>(info.st_size);
+        void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+
+        if (address == MAP_FAILED) {
+            throw std::runtime_error("Cannot map image: " + path.string());
+        }
+        data = static_cast<const uint8_t*>(address);
+    }
+
+    void release(void) {
+        if (data) munmap(const_cast<uint8_t*>(data), size);
+    }
+#endif
+
+    ~MappedFile() { this->release(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+};
+
+template <typename T>
+static T read_field(const uint8_t* data, size_t offset) {
+    // BMP fields are little endian and not necessarily aligned
+    T value;
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+
+static int mask_shift(uint32_t mask) {
+    // Position of the lowest bit of a non-zero channel mask
+    int shift = 0;
+    while (!((mask >> shift) & 0x1)) ++shift;
+    return shift;
+}
+
+static void horizontal_and(const uint8_t* row, uint8_t* out, int width) {
+    // out[x] = row[x-1] & row[x] & row[x+1] with reflected borders,
+    // i.e. 0xff only where the whole 1x3 neighbourhood is object
+    if (width == 1) {
+        out[0] = row[0];
+        return;
+    }
+
+    out[0] = row[0] & row[1];
+    for (int x = 1; x < width - 1; ++x) {
+        out[x] = row[x - 1] & row[x] & row[x + 1];
+    }
+    out[width - 1] = row[width - 2] & row[width - 1];
+}
+
+template <typename DecodeRow>
+static std::vector<uint8_t> trace_edges(int width, int height, DecodeRow decode_row) {
+    // Equivalent of thresholding followed by a 3x3 Laplacian with
+    // reflected borders, over a rolling window of three decoded
+    // rows: an object pixel is an edge if any neighbour is background.
+
+    std::vector<uint8_t> edges(static_cast<size_t>(width) * height);
+    std::vector<uint8_t> mask(width), next_mask(width);
+    std::vector<uint8_t> above(width), center(width), below(width);
+
+    // Rows above and below hold the horizontal_and() of the mask,
+    // so only three row ANDs are left per output pixel.
+    decode_row(0, mask.data());
+    horizontal_and(mask.data(), center.data(), width);
+
+    for (int z = 0; z < height; ++z) {
+        if (z + 1 < height) {
+            decode_row(z + 1, next_mask.data());
+            horizontal_and(next_mask.data(), below.data(), width);
+        } else {
+            // Reflected border: the row below the last one is z - 1
+            below = (height > 1)? above : center;
+        }
+
+        if (z == 0) {
+            // Reflected border: the row above the first one is z + 1
+            above = below;
+        }
+
+        uint8_t* out = edges.data() + static_cast<size_t>(z) * width;
+        const uint8_t* a = above.data();
+        const uint8_t* b = center.data();
+        const uint8_t* c = below.data();
+        const uint8_t* m = mask.data();
+
+        for (int x = 0; x < width; ++x) {
+            out[x] = m[x] & ~(a[x] & b[x] & c[x]);
+        }
+
+        std::swap(above, center);
+        std::swap(center, below);
+        std::swap(mask, next_mask);
+    }
+    return edges;
+}
+
+Silhouette::Silhouette(const std::filesystem::path& path) {
+    // Maps an uncompressed 8, 24 or 32-bit BMP and thresholds it row
+    // by row (white = background) straight into the edge image.
+
+    const MappedFile file(path);
+    const uint8_t* data = file.data;
+
+    if (file.size < BMP_FILE_HEADER + BMP_INFO_HEADER ||
+        data[0] != 'B' || data[1] != 'M') {
+        throw std::runtime_error("Not a BMP image: " + path.string());
+    }
+
+    const uint32_t offset = read_field<uint32_t>(data, 10);
+    const uint32_t header_size = read_field<uint32_t>(data, 14);
+    const int32_t raw_width = read_field<int32_t>(data, 18);
+    const int32_t raw_height = read_field<int32_t>(data, 22);
+    const uint16_t bpp = read_field<uint16_t>(data, 28);
+    const uint32_t compression = read_field<uint32_t>(data, 30);
+
+    if (header_size < BMP_INFO_HEADER) {
+        throw UnsupportedBitmap("Unsupported BMP header: " + path.string());
+    }
+    if ((bpp != 8 && bpp != 24 && bpp != 32) ||
+        (compression != BMP_BI_RGB && !(compression == BMP_BI_BITFIELDS && bpp == 32))) {
+        throw UnsupportedBitmap("Unsupported BMP layout: " + path.string());
+    }
+    if (raw_width <= 0 || raw_height == 0 || raw_height == INT32_MIN) {
+        throw std::runtime_error("Invalid BMP size: " + path.string());
+    }
+
+    this->width = raw_width;
+    this->height = std::abs(raw_height);
+    const bool bottom_up = raw_height > 0;
+    const size_t stride = ((static_cast<size_t>(bpp) * width + 31) / 32) * 4;
+
+    if (offset > file.size || stride * height > file.size - offset) {
+        throw std::runtime_error("Truncated BMP image: " + path.string());
+    }
+
+    const uint8_t* rows = data + offset;
+    const auto row_at = [&](int z) {
+        return rows + stride * (bottom_up? height - 1 - z : z);
+    };
+
+    if (bpp == 8) {
+        // Threshold the palette once, then rows are a table lookup.
+        // Indices past the stored palette are black (object), as
+        // with the zero-filled palette of the OpenCV loader.
+        const uint32_t used = read_field<uint32_t>(data, 46);
+        const size_t palette = BMP_FILE_HEADER + header_size;
+        const size_t colors = (used && used <= 256)? used : 256;
+        uint8_t object[256];
+        std::memset(object, 0xff, sizeof(object));
+
+        for (size_t i = 0; i < colors && palette + 4 * i + 3 <= offset; ++i) {
+            const uint8_t* bgr = data + palette + 4 * i;
+            const int gray = bgr[0] * GRAY_B + bgr[1] * GRAY_G + bgr[2] * GRAY_R;
+            object[i] = (gray < GRAY_WHITE)? 0xff : 0x00;
+        }
+
+        this->pixels = trace_edges(width, height, [&](int z, uint8_t* out) {
+            const uint8_t* in = row_at(z);
+            for (int x = 0; x < width; ++x) {
+                out[x] = object[in[x]];
+            }
+        });
+
+    } else if (bpp == 24) {
+        this->pixels = trace_edges(width, height, [&](int z, uint8_t* out) {
+            const uint8_t* in = row_at(z);
+            for (int x = 0; x < width; ++x) {
+                const int gray = in[3 * x] * GRAY_B + in[3 * x + 1] * GRAY_G
+                    + in[3 * x + 2] * GRAY_R;
+                out[x] = (gray < GRAY_WHITE)? 0xff : 0x00;
+            }
+        });
+
+    } else {
+        // 32-bit: BGRX unless BI_BITFIELDS says otherwise
+        int shift_b = 0, shift_g = 8, shift_r = 16;
+
+        if (compression == BMP_BI_BITFIELDS) {
+            if (file.size < BMP_FILE_HEADER + BMP_INFO_HEADER + BMP_MASKS) {
+                throw std::runtime_error("Truncated BMP image: " + path.string());
+            }
+
+            const uint32_t mask_r = read_field<uint32_t>(data, 54);
+            const uint32_t mask_g = read_field<uint32_t>(data, 58);
+            const uint32_t mask_b = read_field<uint32_t>(data, 62);
+            if (!mask_r || !mask_g || !mask_b) {
+                throw UnsupportedBitmap("Unsupported BMP masks: " + path.string());
+            }
+
+            shift_r = mask_shift(mask_r);
+            shift_g = mask_shift(mask_g);
+            shift_b = mask_shift(mask_b);
+
+            if ((mask_r >> shift_r) != 0xff || (mask_g >> shift_g) != 0xff ||
+                (mask_b >> shift_b) != 0xff) {
+                throw UnsupportedBitmap("Unsupported BMP masks: " + path.string());
+            }
+        }
+
+        this->pixels = trace_edges(width, height, [&](int z, uint8_t* out) {
+            const uint8_t* in = row_at(z);
+            for (int x = 0; x < width; ++x) {
+                const uint32_t pixel = read_field<uint32_t>(in, 4 * static_cast<size_t>(x));
+                const int gray = static_cast<int>((pixel >> shift_b) & 0xff) * GRAY_B
+                    + static_cast<int>((pixel >> shift_g) & 0xff) * GRAY_G
+                    + static_cast<int>((pixel >> shift_r) & 0xff) * GRAY_R;
+                out[x] = (gray < GRAY_WHITE)? 0xff : 0x00;
+            }
+        });
+    }
+}
+
+Silhouette::Silhouette(const int width, const int height, std::vector<uint8_t> pixels) :
+    width(width), height(height), pixels(std::move(pixels)) {}
+
+Silhouette Silhouette::from_gray(const uint8_t* gray, const int width,
+    const int height, const size_t stride) {
+    // In-memory 8-bit image, top-down rows; 255 is background
+    // like the white of plane.bmp, any other value is object.
+
+    if (!gray || width <= 0 || height <= 0 || stride < static_cast<size_t>(width)) {
+        throw std::invalid_argument("Invalid silhouette buffer");
+    }
+
+    std::vector<uint8_t> edges = trace_edges(width, height, [&](int z, uint8_t* out) {
+        const uint8_t* in = gray + stride * z;
+        for (int x = 0; x < width; ++x) {
+            out[x] = (in[x] != 0xff)? 0xff : 0x00;
+        }
+    });
+    return Silhouette(width, height, std::move(edges));
+}
+
+uint8_t Silhouette::at(const int x, const int z) const {
+    return pixels[static_cast<size_t>(z) * width + x];
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+
+#define SILHOUETTE_EDGE 0xff
+
+// Thrown for BMP layouts that the mapped loader does not
+// decode (compressed, 1/4/16-bit, OS/2 headers...)
+struct UnsupportedBitmap : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+struct Silhouette {
+    int width;
+    int height;
+    // Top-down, row-major. SILHOUETTE_EDGE marks the pixels of the
+    // object that touch the background (8-neighbourhood), else 0.
+    std::vector<uint8_t> pixels;
+
+    Silhouette(const std::filesystem::path& path);
+    Silhouette(int width, int height, std::vector<uint8_t> pixels);
+    static Silhouette from_gray(const uint8_t* gray, int width, int height, size_t stride);
+    uint8_t at(int x, int z) const;
+};
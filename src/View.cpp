@@ -3,6 +3,7 @@
 #include <opencv2/imgproc.hpp>
 #include <Eigen/Dense>
 #include <nlohmann/json.hpp>
+#include "Silhouette.hpp"
 #include "View.hpp"
 
 
@@ -15,16 +16,16 @@ void ensure_vector_format(const nlohmann::json &item, const std::string &field)
     }
 }
 
-std::vector<Vector2> get_contour_polygon(const cv::Mat& img) {
-    const int height = img.rows;
-    const int width = img.cols;
+std::vector<Vector2> get_contour_polygon(const Silhouette& img) {
+    const int height = img.height;
+    const int width = img.width;
 
     // Find starting point
     std::pair<int, int> start{-1, -1};
     bool found = false;
     for (int z = 1; z < height - 1 && !found; ++z) {
         for (int x = 1; x < width - 1 && !found; ++x) {
-            if (img.at<uchar>(z, x) == 0xff) {
+            if (img.at(x, z) == SILHOUETTE_EDGE) {
                 start = {x, z};
                 found = true;
             }
@@ -48,10 +49,10 @@ std::vector<Vector2> get_contour_polygon(const cv::Mat& img) {
 
     do {
         // Check if current pixel is a vertex
-        uchar horz = img.at<uchar>(cz, cx - 1) | img.at<uchar>(cz, cx + 1);
-        uchar vert = img.at<uchar>(cz - 1, cx) | img.at<uchar>(cz + 1, cx);
+        uint8_t horz = img.at(cx - 1, cz) | img.at(cx + 1, cz);
+        uint8_t vert = img.at(cx, cz - 1) | img.at(cx, cz + 1);
 
-        if (horz == 0xff && vert == 0xff) {
+        if (horz == SILHOUETTE_EDGE && vert == SILHOUETTE_EDGE) {
             // Vertex found (x, -z)
             points.push_back(Vector2{
                 static_cast<float>(cx),
@@ -67,7 +68,7 @@ std::vector<Vector2> get_contour_polygon(const cv::Mat& img) {
 
             // Check bounds
             if (nx >= 0 && nx < width && nz >= 0 && nz < height) {
-                if (img.at<uchar>(nz, nx) == 0xff && (nx != px || nz != pz)) {
+                if (img.at(nx, nz) == SILHOUETTE_EDGE && (nx != px || nz != pz)) {
                     px = cx;
                     pz = cz;
                     cx = nx;
@@ -86,6 +87,51 @@ std::vector<Vector2> get_contour_polygon(const cv::Mat& img) {
     return points;
 }
 
+std::vector<Vector2> centered_contour(const Silhouette& silhouette) {
+    // Extract the view's contour polygonal line
+    // Then center the points for normalization
+    auto vertices = get_contour_polygon(silhouette);
+
+    if (!vertices.empty()) {
+        float min_x = vertices[0].x, max_x = vertices[0].x;
+        float min_y = vertices[0].y, max_y = vertices[0].y;
+
+        for (const auto& vertex : vertices) {
+            min_x = std::min(min_x, vertex.x);
+            max_x = std::max(max_x, vertex.x);
+            min_y = std::min(min_y, vertex.y);
+            max_y = std::max(max_y, vertex.y);
+        }
+
+        const float center_x = (min_x + max_x) / 2.0f;
+        const float center_y = (min_y + max_y) / 2.0f;
+
+        for (auto& vertex : vertices) {
+            vertex.x -= center_x;
+            vertex.y -= center_y;
+        }
+    }
+    return vertices;
+}
+
+Silhouette load_silhouette(const std::filesystem::path& plane_path) {
+    // Mapped loader first, OpenCV only for layouts it does not decode
+    try {
+        return Silhouette(plane_path);
+    } catch (const UnsupportedBitmap&) {}
+
+    cv::Mat src = cv::imread(plane_path.string(), cv::IMREAD_GRAYSCALE);
+    if (src.empty()) {
+        throw std::runtime_error("Cannot load image: " + plane_path.string());
+    }
+
+    cv::threshold(src, src, 254, 255, cv::THRESH_BINARY_INV);
+    cv::Mat laplacian = (cv::Mat_<char>(3,3) << -1, -1, -1, -1, 8, -1, -1, -1, -1);
+    cv::Mat dst;
+    cv::filter2D(src, dst, -1, laplacian);
+    return Silhouette(dst.cols, dst.rows, std::vector<uint8_t>(dst.datastart, dst.dataend));
+}
+
 View::View(const std::filesystem::path &path) {
     const auto camera_path = path / "camera.json";
     const auto plane_path = path / "plane.bmp";
@@ -129,43 +175,16 @@ View::View(const std::filesystem::path &path) {
     this->vy = Vector3{vy_vec[0], vy_vec[1], vy_vec[2]};
     this->vz = Vector3{vz_vec[0], vz_vec[1], vz_vec[2]};
 
-    // Load the view's projection
-    cv::Mat src = cv::imread(plane_path.string(), cv::IMREAD_GRAYSCALE);
-    if (src.empty()) {
-        throw std::runtime_error("Cannot load image: " + plane_path.string());
-    }
-
-    cv::threshold(src, src, 254, 255, cv::THRESH_BINARY_INV);
-    cv::Mat laplacian = (cv::Mat_<char>(3,3) << -1, -1, -1, -1, 8, -1, -1, -1, -1);
-    cv::Mat dst;
-    cv::filter2D(src, dst, -1, laplacian);
-
-    // Extract the view's contour polygonal line
-    // Then center the points for normalization
-    auto vertices = get_contour_polygon(dst);
-
-    if (!vertices.empty()) {
-        float min_x = vertices[0].x, max_x = vertices[0].x;
-        float min_y = vertices[0].y, max_y = vertices[0].y;
-
-        for (const auto& vertex : vertices) {
-            min_x = std::min(min_x, vertex.x);
-            max_x = std::max(max_x, vertex.x);
-            min_y = std::min(min_y, vertex.y);
-            max_y = std::max(max_y, vertex.y);
-        }
-
-        const float center_x = (min_x + max_x) / 2.0f;
-        const float center_y = (min_y + max_y) / 2.0f;
-
-        for (auto& vertex : vertices) {
-            vertex.x -= center_x;
-            vertex.y -= center_y;
-        }
-        this->polygon = vertices;
-    }
+    // Load the view's projection and its contour
+    const Silhouette silhouette = load_silhouette(plane_path);
+    this->polygon = centered_contour(silhouette);
 }
 
+View::View(const std::string& name, const Vector3& origin, const Vector3& vx,
+    const Vector3& vy, const Vector3& vz, const Silhouette& silhouette) :
+    name(name), origin(origin), vx(vx), vy(vy), vz(vz),
+    polygon(centered_contour(silhouette)) {}
+
 Vector3 View::plane_to_real(const Vector2 &point) const {
     const float x = this->origin.x + (this->vx.x * point.x) + (this->vz.x * point.y);
     const float y = this->origin.y + (this->vx.y * point.x) + (this->vz.y * point.y);
@@ -232,6 +251,18 @@ std::array<float, VNUM_BOUNDS> View::get_bounds() const {
     return {min_x, min_y, max_x, max_y};
 }
 
+float View::get_area() const {
+    // Shoelace formula over the contour polygon
+    float area = 0.0f;
+    size_t j = polygon.size() - 1;
+
+    for (size_t i = 0; i < polygon.size(); i++) {
+        area += (polygon[j].x + polygon[i].x) * (polygon[j].y - polygon[i].y);
+        j = i;
+    }
+    return std::abs(area) / 2.0f;
+}
+
 std::string vector_to_string(const Vector3 &vector) {
     return "[" + std::to_string(vector.x) + "," +
            std::to_string(vector.y) + "," +
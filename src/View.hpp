@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <raymath.h>
+#include "Silhouette.hpp"
 
 #define VNUM_BOUNDS 4 // min{x,y}, max{x,y}
 
@@ -22,10 +23,13 @@ struct View {
     std::vector<Vector2> polygon;
 
     View(const std::filesystem::path& path);
+    View(const std::string& name, const Vector3& origin, const Vector3& vx,
+        const Vector3& vy, const Vector3& vz, const Silhouette& silhouette);
     Vector3 plane_to_real(const Vector2& point) const;
     Vector2 real_to_plane(const Vector3& point) const;
     std::string to_string() const;
     View::Direction get_direction() const;
     bool is_point_inside_contour(const Vector2& point) const;
     std::array<float, VNUM_BOUNDS> get_bounds() const;
+    float get_area() const;
 };
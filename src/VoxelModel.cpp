@@ -1,17 +1,55 @@
 #include <filesystem>
 #include <iostream>
 #include <algorithm>
+#include <fstream>
+#include <utility>
 #include "VoxelModel.hpp"
 
 VoxelModel::VoxelModel(const std::filesystem::path &path, const int resolution,
-    const bool print_info) : path(path), resolution(resolution),
-    print_info(print_info) {
+    const bool print_info, const ComponentFilter& component_filter) :
+    VoxelModel(path, load_views(path), resolution, print_info, component_filter) {}
 
+VoxelModel::VoxelModel(const std::filesystem::path &path, std::vector<View> views,
+    const int resolution, const bool print_info, const ComponentFilter& component_filter,
+    const bool verbose) : views(std::move(views)), path(path), resolution(resolution),
+    print_info(print_info), component_filter(component_filter), verbose(verbose) {
+
+    if (this->views.empty()) {
+        throw std::runtime_error("No valid views found in: " + path.string());
+    }
+    bounds.fill(0.0f);
+
+    if (verbose) {
+        std::cout << "[+] Starting initial reconstruction" << std::endl;
+        this->print_model_info();
+    }
+    this->calculate_bounds();
+    this->initial_reconstruction();
+    
+    if (verbose) std::cout << "[+] Refining model" << std::endl;
+    this->model_refinement();
+
+    if (component_filter.policy != ComponentFilter::Policy::NONE) {
+        const size_t removed = this->component_filter.apply(this->space);
+        if (verbose) {
+            std::cout << "[+] Removed " << removed << " voxels of carving debris" << std::endl;
+        }
+    }
+    
+    if (verbose) std::cout << "[+] Generating surface" << std::endl;
+    this->surface_generation();
+
+    if (print_info) {
+        this->additional_info();
+    }  
+}
+
+std::vector<View> VoxelModel::load_views(const std::filesystem::path &path) {
     if (!std::filesystem::exists(path))
         throw std::runtime_error("Not a valid path: " + path.string());
-    bounds.fill(0.0f);
 
     // Load all views
+    std::vector<View> views;
     for (const auto& entry : std::filesystem::directory_iterator(path)) {
         if (entry.is_directory()) {
             try {
@@ -23,25 +61,7 @@ VoxelModel::VoxelModel(const std::filesystem::path &path, const int resolution,
             }
         }
     }
-
-    if (views.empty()) {    
-        throw std::runtime_error("No valid views found in: " + path.string());
-    }
-
-    std::cout << "[+] Starting initial reconstruction" << std::endl;
-    this->print_model_info();
-    this->calculate_bounds();
-    this->initial_reconstruction();
-    
-    std::cout << "[+] Refining model" << std::endl;
-    this->model_refinement();
-    
-    std::cout << "[+] Generating surface" << std::endl;
-    this->surface_generation();
-
-    if (print_info) {
-        this->additional_info();
-    }  
+    return views;
 }
 
 void VoxelModel::print_model_info() const {
@@ -85,22 +105,85 @@ void VoxelModel::initial_reconstruction() {
     // Initialize the voxel space to all voxels set (true)
     space = Eigen::Tensor<bool, SPACE_DIM>(resolution, resolution, resolution);
     space.setConstant(true);
+
+    for (auto& counts : column_counts) {
+        counts.assign(static_cast<size_t>(resolution) * resolution, resolution);
+    }
 }
 
 void VoxelModel::model_refinement() {
+    // Most selective views (smallest filled area) carve first, so
+    // later views find more columns already empty and skip them
+    std::vector<const View*> order;
+    std::vector<float> fractions;
+
     for (const auto& view : views) {
-        std::cout << "[+] Using " << view.name << " to reconstruct." << std::endl;
-        project_view_to_voxels(view);
+        order.push_back(&view);
+        fractions.push_back(filled_fraction(view));
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&](const View* a, const View* b) {
+        return fractions[a - views.data()] < fractions[b - views.data()];
+    });
+
+    for (const View* view : order) {
+        if (verbose) {
+            std::cout << "[+] Using " << view->name << " to reconstruct." << std::endl;
+        }
+        const size_t skipped = project_view_to_voxels(*view);
+
+        if (print_info) {
+            std::cout << "[!] Filled fraction: " << fractions[view - views.data()]
+                << ", empty columns skipped: " << skipped << std::endl;
+        }
     }
 }
 
+float VoxelModel::filled_fraction(const View& view) const {
+    // Contour area over the area sampled for the view's direction
+    float width = 0.0f, height = 0.0f;
+
+    switch (view.get_direction()) {
+        case View::Direction::XY:
+            width = bounds[1] - bounds[0];
+            height = bounds[3] - bounds[2];
+            break;
+        case View::Direction::XZ:
+            width = bounds[1] - bounds[0];
+            height = bounds[5] - bounds[4];
+            break;
+        case View::Direction::YZ:
+            width = bounds[3] - bounds[2];
+            height = bounds[5] - bounds[4];
+            break;
+    }
+
+    const float area = width * height;
+    return (area > 0.0f)? std::min(1.0f, view.get_area() / area) : 1.0f;
+}
+
+void VoxelModel::carve_voxel(const int x, const int y, const int z) {
+    // Clears a voxel and updates the three columns crossing it
+    if (!space(x, y, z)) {
+        return;
+    }
+
+    space(x, y, z) = false;
+    --column_counts[0][y + resolution * z];
+    --column_counts[1][x + resolution * z];
+    --column_counts[2][x + resolution * y];
+}
+
 float VoxelModel::interpolate_bounds(float min_val, float max_val, int index) const {
     if (resolution <= 1) return min_val;
     return min_val + index * (max_val - min_val) / (resolution - 1);
 }
 
-void VoxelModel::project_view_to_voxels(const View& view) {
+size_t VoxelModel::project_view_to_voxels(const View& view) {
+    // Returns how many columns were skipped because earlier
+    // views had already emptied them
     View::Direction direction = view.get_direction();
+    size_t skipped = 0;
         
     for (int i = 0; i < resolution; ++i) {
         for (int j = 0; j < resolution; ++j) {
@@ -110,6 +193,11 @@ void VoxelModel::project_view_to_voxels(const View& view) {
             switch (direction) {
                 case View::Direction::XY: {
                     // The view's plane is parallel to the XY space plane
+                    if (column_counts[2][i + resolution * j] == 0) {
+                        ++skipped;
+                        break;
+                    }
+
                     const float wx = interpolate_bounds(bounds[0], bounds[1], i);
                     const float wy = interpolate_bounds(bounds[2], bounds[3], j);
                     world_point = {wx, wy, 0.0f};
@@ -118,7 +206,7 @@ void VoxelModel::project_view_to_voxels(const View& view) {
                     if (!view.is_point_inside_contour(plane_point)) {
                         // Remove entire Z column
                         for (int k = 0; k < resolution; ++k) {
-                            space(i, j, k) = false;
+                            carve_voxel(i, j, k);
                         }
                     }
                     break;
@@ -126,6 +214,11 @@ void VoxelModel::project_view_to_voxels(const View& view) {
 
                 case View::Direction::XZ: {
                     // The view's plane is parallel to the XZ space plane
+                    if (column_counts[1][i + resolution * j] == 0) {
+                        ++skipped;
+                        break;
+                    }
+
                     const float wx = interpolate_bounds(bounds[0], bounds[1], i);
                     const float wz = interpolate_bounds(bounds[4], bounds[5], j);
                     world_point = {wx, 0.0f, wz};
@@ -134,7 +227,7 @@ void VoxelModel::project_view_to_voxels(const View& view) {
                     if (!view.is_point_inside_contour(plane_point)) {
                         // Remove entire Y row
                         for (int k = 0; k < resolution; ++k) {
-                            space(i, k, j) = false;
+                            carve_voxel(i, k, j);
                         }
                     }
                     break;
@@ -142,6 +235,11 @@ void VoxelModel::project_view_to_voxels(const View& view) {
 
                 case View::Direction::YZ: {
                     // The view's plane is parallel to the YZ space plane
+                    if (column_counts[0][i + resolution * j] == 0) {
+                        ++skipped;
+                        break;
+                    }
+
                     const float wy = interpolate_bounds(bounds[2], bounds[3], i);
                     const float wz = interpolate_bounds(bounds[4], bounds[5], j);
                     world_point = {0.0f, wy, wz};
@@ -150,7 +248,7 @@ void VoxelModel::project_view_to_voxels(const View& view) {
                     if (!view.is_point_inside_contour(plane_point)) {
                         // Remove entire X column
                         for (int k = 0; k < resolution; ++k) {
-                            space(k, i, j) = false;
+                            carve_voxel(k, i, j);
                         }
                     }
                     break;
@@ -158,6 +256,7 @@ void VoxelModel::project_view_to_voxels(const View& view) {
             }
         }
     }
+    return skipped;
 }
 
 void VoxelModel::surface_generation() {
@@ -190,3 +289,40 @@ void VoxelModel::additional_info() const {
     std::cout << "[!] Number of voxels: " << (resolution * resolution * resolution) << std::endl;
     std::cout << "[!] Number of active voxels: " << cubes.size() << std::endl;
 }
+
+
+void VoxelModel::export_obj(const std::filesystem::path &output) const {
+    // Writes every surface cube as an 8 vertex, 6 face
+    // Wavefront OBJ block centered at the cube position
+
+    std::ofstream stream(output);
+    if (!stream.is_open()) {
+        throw std::runtime_error("Cannot open output file: " + output.string());
+    }
+
+    const float hx = cube_dimensions.x / 2.0f;
+    const float hy = cube_dimensions.y / 2.0f;
+    const float hz = cube_dimensions.z / 2.0f;
+    size_t base = 1;
+
+    for (const auto& cube : cubes) {
+        for (int corner = 0; corner < 8; ++corner) {
+            stream << "v "
+                << cube.x + ((corner & 0x1)? hx : -hx) << " "
+                << cube.y + ((corner & 0x2)? hy : -hy) << " "
+                << cube.z + ((corner & 0x4)? hz : -hz) << "\n";
+        }
+
+        // Faces -x, +x, -y, +y, -z, +z (corner bits: x=1, y=2, z=4)
+        static const int faces[6][4] = {
+            {0, 4, 6, 2}, {1, 3, 7, 5}, {0, 1, 5, 4},
+            {2, 6, 7, 3}, {0, 2, 3, 1}, {4, 5, 7, 6},
+        };
+
+        for (const auto& face : faces) {
+            stream << "f " << base + face[0] << " " << base + face[1] << " "
+                << base + face[2] << " " << base + face[3] << "\n";
+        }
+        base += 8;
+    }
+}
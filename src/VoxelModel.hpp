@@ -4,6 +4,7 @@
 #include <filesystem>
 #include <unsupported/Eigen/CXX11/Tensor>
 #include <raymath.h>
+#include "ComponentFilter.hpp"
 #include "View.hpp"
 
 // space axes {x,y,z}
@@ -22,16 +23,31 @@ struct VoxelModel {
 	Vector3 cube_dimensions;
 	int resolution;
 	bool print_info;
+	ComponentFilter component_filter;
+	bool verbose;
 	
-	VoxelModel(const std::filesystem::path& path, int resolution, bool print_info);
+	VoxelModel(const std::filesystem::path& path, int resolution, bool print_info,
+		const ComponentFilter& component_filter = ComponentFilter());
+	VoxelModel(const std::filesystem::path& path, std::vector<View> views,
+		int resolution, bool print_info,
+		const ComponentFilter& component_filter = ComponentFilter(),
+		bool verbose = true);
+	static std::vector<View> load_views(const std::filesystem::path& path);
+	void export_obj(const std::filesystem::path& output) const;
 
 private:
+	// Voxels still set in every column, per axis: [0] columns along x
+	// indexed (y, z), [1] along y indexed (x, z), [2] along z (x, y)
+	std::array<std::vector<int>, SPACE_DIM> column_counts;
+
 	void initial_reconstruction(void);
 	void model_refinement(void);
 	void surface_generation(void);
 	void additional_info(void) const;
 	void calculate_bounds(void);
 	void print_model_info(void) const;
-	void project_view_to_voxels(const View& view);
+	size_t project_view_to_voxels(const View& view);
+	void carve_voxel(int x, int y, int z);
+	float filled_fraction(const View& view) const;
 	float interpolate_bounds(float min_val, float max_val, int index) const;
 };
@@ -0,0 +1,287 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <raymath.h>
+#include "VoxelRaycaster.hpp"
+#define RADIANS(deg) (deg * M_PI / 180.0f)
+
+// Same clear color as ModelRender::start_render_loop
+static const Color background {10, 10, 10, 255};
+
+
+static float grid_spacing(float min_val, float max_val, float cube_size, int resolution) {
+    // Distance between voxel centers (see interpolate_bounds)
+    const float spacing = (resolution > 1)?
+        (max_val - min_val) / (resolution - 1) : cube_size;
+    return (spacing > 0.0f)? spacing : 1.0f;
+}
+
+VoxelRaycaster::VoxelRaycaster(const VoxelModel* model, const int width,
+    const int height, const unsigned int num_threads) :
+    model(model),
+    width(width),
+    height(height),
+    num_threads(num_threads? num_threads : 1) {
+
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("image size must be positive");
+    }
+
+    // The model's (x, y, z) is drawn as (x, z, y), voxel centers
+    // sit in the middle of each cell of the traversal grid. The
+    // cells are as far apart as the centers (extent / (res - 1)),
+    // the cubes keep draw_model's size (extent / res) inside them.
+    const auto& bounds = model->bounds;
+    const int resolution = model->resolution;
+
+    this->cell_size = {
+        grid_spacing(bounds[0], bounds[1], model->cube_dimensions.x, resolution),
+        grid_spacing(bounds[4], bounds[5], model->cube_dimensions.z, resolution),
+        grid_spacing(bounds[2], bounds[3], model->cube_dimensions.y, resolution),
+    };
+
+    this->grid_min = {
+        bounds[0] - cell_size.x / 2.0f,
+        bounds[4] - cell_size.y / 2.0f,
+        bounds[2] - cell_size.z / 2.0f,
+    };
+
+    // Same arguments as the DrawCube call in draw_model
+    this->cube_size = model->cube_dimensions;
+}
+
+bool VoxelRaycaster::is_occupied(const int x, const int y, const int z) const {
+    return this->model->space(x, z, y);
+}
+
+Color VoxelRaycaster::trace(const Vector3& origin, const Vector3& direction) const {
+    // Clips the ray against the grid box, then walks the cells
+    // it crosses (3D-DDA) until one is occupied or it leaves.
+
+    const int resolution = this->model->resolution;
+    const float o[3] = {origin.x, origin.y, origin.z};
+    const float d[3] = {direction.x, direction.y, direction.z};
+    const float lo[3] = {grid_min.x, grid_min.y, grid_min.z};
+    const float cs[3] = {cell_size.x, cell_size.y, cell_size.z};
+    const float inf = std::numeric_limits<float>::infinity();
+
+    float t_enter = 0.0f;
+    float t_exit = inf;
+    int axis = -1;
+
+    for (int a = 0; a < 3; ++a) {
+        const float hi = lo[a] + cs[a] * resolution;
+
+        if (d[a] == 0.0f) {
+            if (o[a] < lo[a] || o[a] > hi) return background;
+            continue;
+        }
+
+        float t0 = (lo[a] - o[a]) / d[a];
+        float t1 = (hi - o[a]) / d[a];
+        if (t0 > t1) std::swap(t0, t1);
+
+        if (t0 > t_enter) {
+            t_enter = t0;
+            axis = a;
+        }
+        t_exit = std::min(t_exit, t1);
+    }
+
+    if (t_enter > t_exit) {
+        return background;
+    }
+
+    int cell[3], step[3];
+    float t_max[3], t_delta[3];
+
+    for (int a = 0; a < 3; ++a) {
+        const float p = o[a] + d[a] * t_enter;
+        cell[a] = std::clamp(static_cast<int>(std::floor((p - lo[a]) / cs[a])),
+            0, resolution - 1);
+
+        if (d[a] > 0.0f) {
+            step[a] = 1;
+            t_max[a] = (lo[a] + (cell[a] + 1) * cs[a] - o[a]) / d[a];
+            t_delta[a] = cs[a] / d[a];
+        } else if (d[a] < 0.0f) {
+            step[a] = -1;
+            t_max[a] = (lo[a] + cell[a] * cs[a] - o[a]) / d[a];
+            t_delta[a] = -cs[a] / d[a];
+        } else {
+            step[a] = 0;
+            t_max[a] = inf;
+            t_delta[a] = inf;
+        }
+    }
+
+    while (!this->is_occupied(cell[0], cell[1], cell[2]) ||
+        !this->hit_cube(cell, o, d, axis)) {
+        axis = (t_max[0] < t_max[1])?
+            ((t_max[0] < t_max[2])? 0 : 2) :
+            ((t_max[1] < t_max[2])? 1 : 2);
+
+        cell[axis] += step[axis];
+        if (cell[axis] < 0 || cell[axis] >= resolution) {
+            return background;
+        }
+        t_max[axis] += t_delta[axis];
+    }
+
+    // Lambert on the face the ray entered through (or a headlight
+    // when the camera starts inside the cube)
+    Vector3 normal = Vector3Scale(direction, -1.0f);
+    if (axis >= 0) {
+        float n[3] = {0.0f, 0.0f, 0.0f};
+        n[axis] = (d[axis] > 0.0f)? -1.0f : 1.0f;
+        normal = {n[0], n[1], n[2]};
+    }
+
+    const Vector3 light = Vector3Normalize({0.4f, 1.0f, 0.6f});
+    const float diffuse = std::max(0.0f, Vector3DotProduct(normal, light));
+    const float facing = std::abs(Vector3DotProduct(normal, direction));
+    const float shade = std::min(1.0f, 0.25f + 0.5f * diffuse + 0.25f * facing);
+    const unsigned char value = static_cast<unsigned char>(255.0f * shade);
+    return Color{value, value, value, 255};
+}
+
+bool VoxelRaycaster::hit_cube(const int cell[3], const float origin[3],
+    const float direction[3], int& axis) const {
+    // Slab test against the cube centered in the cell; on a hit,
+    // axis is the face the ray enters through (-1 if inside).
+
+    const float lo[3] = {grid_min.x, grid_min.y, grid_min.z};
+    const float cs[3] = {cell_size.x, cell_size.y, cell_size.z};
+    const float half[3] = {cube_size.x / 2.0f, cube_size.y / 2.0f, cube_size.z / 2.0f};
+    const float inf = std::numeric_limits<float>::infinity();
+
+    float t_near = -inf;
+    float t_far = inf;
+    int near_axis = -1;
+
+    for (int a = 0; a < 3; ++a) {
+        const float center = lo[a] + (cell[a] + 0.5f) * cs[a];
+        const float min_val = center - half[a];
+        const float max_val = center + half[a];
+
+        if (direction[a] == 0.0f) {
+            if (origin[a] < min_val || origin[a] > max_val) return false;
+            continue;
+        }
+
+        float t0 = (min_val - origin[a]) / direction[a];
+        float t1 = (max_val - origin[a]) / direction[a];
+        if (t0 > t1) std::swap(t0, t1);
+
+        if (t0 > t_near) {
+            t_near = t0;
+            near_axis = a;
+        }
+        t_far = std::min(t_far, t1);
+    }
+
+    if (t_near > t_far || t_far < 0.0f) {
+        return false;
+    }
+
+    axis = (t_near >= 0.0f)? near_axis : -1;
+    return true;
+}
+
+std::vector<Color> VoxelRaycaster::render(const Camera3D& camera) const {
+    // Casts one ray per pixel center through a pinhole camera with
+    // the same parameters as the raylib one; tiles are claimed by
+    // the worker threads from a shared counter.
+
+    const Vector3 forward = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
+    const Vector3 right = Vector3Normalize(Vector3CrossProduct(forward, camera.up));
+    const Vector3 up = Vector3CrossProduct(right, forward);
+    const float half_height = std::tan(RADIANS(camera.fovy) / 2.0f);
+    const float half_width = half_height * width / height;
+
+    const int tiles_x = (width + TILE_SIZE - 1) / TILE_SIZE;
+    const int tiles_y = (height + TILE_SIZE - 1) / TILE_SIZE;
+    const int tiles = tiles_x * tiles_y;
+
+    std::vector<Color> pixels(static_cast<size_t>(width) * height);
+    std::atomic<int> next_tile{0};
+
+    const auto worker = [&]() {
+        for (int tile = next_tile++; tile < tiles; tile = next_tile++) {
+            const int x0 = (tile % tiles_x) * TILE_SIZE;
+            const int y0 = (tile / tiles_x) * TILE_SIZE;
+            const int x1 = std::min(x0 + TILE_SIZE, width);
+            const int y1 = std::min(y0 + TILE_SIZE, height);
+
+            for (int y = y0; y < y1; ++y) {
+                const float v = (1.0f - 2.0f * (y + 0.5f) / height) * half_height;
+
+                for (int x = x0; x < x1; ++x) {
+                    const float u = (2.0f * (x + 0.5f) / width - 1.0f) * half_width;
+                    const Vector3 direction = Vector3Normalize(Vector3Add(forward,
+                        Vector3Add(Vector3Scale(right, u), Vector3Scale(up, v))));
+                    pixels[static_cast<size_t>(y) * width + x] =
+                        this->trace(camera.position, direction);
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < num_threads; ++i) {
+        workers.emplace_back(worker);
+    }
+
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    return pixels;
+}
+
+void VoxelRaycaster::render_to_file(const Camera3D& camera,
+    const std::filesystem::path& output) const {
+    // The format is picked by raylib from the file extension
+
+    std::vector<Color> pixels = this->render(camera);
+    const Image image {
+        .data = pixels.data(),
+        .width = width,
+        .height = height,
+        .mipmaps = 1,
+        .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8,
+    };
+
+    if (!ExportImage(image, output.string().c_str())) {
+        throw std::runtime_error("Cannot write image: " + output.string());
+    }
+    std::cout << "[+] Image written to " << output << std::endl;
+}
+
+void VoxelRaycaster::render_turntable(const Camera3D& camera, const int angles,
+    const std::filesystem::path& output) const {
+    // Orbits the camera around its up axis (as in auto-rotate) and
+    // writes one image per angle: <stem>_000<ext>, <stem>_001<ext>...
+
+    const Vector3 offset = Vector3Subtract(camera.position, camera.target);
+    Camera3D frame_camera = camera;
+
+    for (int i = 0; i < angles; ++i) {
+        const float angle = 2.0f * PI * i / angles;
+        frame_camera.position = Vector3Add(camera.target,
+            Vector3RotateByAxisAngle(offset, camera.up, angle));
+
+        char suffix[16];
+        std::snprintf(suffix, sizeof(suffix), "_%03d", i);
+        std::filesystem::path frame_path = output;
+        frame_path.replace_filename(output.stem().string() + suffix
+            + output.extension().string());
+
+        this->render_to_file(frame_camera, frame_path);
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <filesystem>
+#include <vector>
+#include <raylib.h>
+#include "VoxelModel.hpp"
+
+// Square tiles handed out to the worker threads
+#define TILE_SIZE 32
+
+
+struct VoxelRaycaster {
+
+    const VoxelModel* model;
+    const int width;
+    const int height;
+    const unsigned int num_threads;
+
+    VoxelRaycaster(const VoxelModel* model, int width, int height,
+        unsigned int num_threads);
+    std::vector<Color> render(const Camera3D& camera) const;
+    void render_to_file(const Camera3D& camera, const std::filesystem::path& output) const;
+    void render_turntable(const Camera3D& camera, int angles,
+        const std::filesystem::path& output) const;
+
+private:
+    // Voxel grid in render space (x, z, y of the model), see draw_model.
+    // Cubes are drawn cube_size wide, a bit smaller than their cell.
+    Vector3 grid_min;
+    Vector3 cell_size;
+    Vector3 cube_size;
+
+    Color trace(const Vector3& origin, const Vector3& direction) const;
+    bool is_occupied(int x, int y, int z) const;
+    bool hit_cube(const int cell[3], const float origin[3], const float direction[3],
+        int& axis) const;
+};
@@ -0,0 +1,178 @@
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "recons.h"
+#include "Silhouette.hpp"
+#include "View.hpp"
+#include "VoxelModel.hpp"
+
+// The grid and cube buffers are handed out as-is
+static_assert(sizeof(bool) == sizeof(uint8_t), "bool must be one byte");
+static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3 must be packed");
+
+static thread_local std::string last_error;
+
+struct recons_model {
+    int resolution;
+    ComponentFilter component_filter;
+    std::vector<View> views;
+    std::unique_ptr<VoxelModel> result;
+};
+
+
+static recons_status fail(const recons_status status, const std::string& message) {
+    last_error = message;
+    return status;
+}
+
+template <typename Call>
+static recons_status guarded(Call call) {
+    // No exception may cross the C boundary
+    try {
+        return call();
+    } catch (const std::bad_alloc&) {
+        return fail(RECONS_FAILURE, "Out of memory");
+    } catch (const std::invalid_argument& e) {
+        return fail(RECONS_INVALID_ARGUMENT, e.what());
+    } catch (const std::exception& e) {
+        return fail(RECONS_FAILURE, e.what());
+    } catch (...) {
+        return fail(RECONS_FAILURE, "Unknown error");
+    }
+}
+
+static Vector3 to_vector(const float value[3]) {
+    return Vector3{value[0], value[1], value[2]};
+}
+
+extern "C" {
+
+int recons_abi_version(void) {
+    return RECONS_ABI_VERSION;
+}
+
+const char* recons_last_error(void) {
+    return last_error.c_str();
+}
+
+recons_status recons_model_create(const int resolution, recons_model** model) {
+    if (!model || resolution <= 0) {
+        return fail(RECONS_INVALID_ARGUMENT, "model must be set and resolution positive");
+    }
+
+    return guarded([&] {
+        *model = new recons_model{resolution, ComponentFilter(), {}, nullptr};
+        return RECONS_OK;
+    });
+}
+
+void recons_model_destroy(recons_model* model) {
+    delete model;
+}
+
+recons_status recons_model_set_component_filter(recons_model* model,
+    const recons_component_policy policy, const int min_size) {
+
+    if (!model || policy < RECONS_KEEP_ALL || policy > RECONS_MIN_SIZE ||
+        (policy == RECONS_MIN_SIZE && min_size <= 0)) {
+        return fail(RECONS_INVALID_ARGUMENT, "invalid component filter");
+    }
+
+    model->component_filter = ComponentFilter(static_cast<ComponentFilter::Policy>(policy),
+        min_size, std::thread::hardware_concurrency());
+    return RECONS_OK;
+}
+
+recons_status recons_model_add_view(recons_model* model, const recons_camera* camera,
+    const uint8_t* pixels, const int width, const int height, const size_t stride) {
+
+    if (!model || !camera || !pixels) {
+        return fail(RECONS_INVALID_ARGUMENT, "model, camera and pixels must be set");
+    }
+
+    return guarded([&] {
+        const Silhouette silhouette = Silhouette::from_gray(pixels, width, height, stride);
+        model->views.emplace_back(camera->name? camera->name : "",
+            to_vector(camera->origin), to_vector(camera->vx),
+            to_vector(camera->vy), to_vector(camera->vz), silhouette);
+        return RECONS_OK;
+    });
+}
+
+recons_status recons_model_run(recons_model* model) {
+    if (!model) {
+        return fail(RECONS_INVALID_ARGUMENT, "model must be set");
+    }
+
+    // The previous result (and its buffers) survive a failed run
+    return guarded([&] {
+        model->result = std::make_unique<VoxelModel>(std::filesystem::path(),
+            model->views, model->resolution, false, model->component_filter, false);
+        return RECONS_OK;
+    });
+}
+
+recons_status recons_model_grid(const recons_model* model,
+    const uint8_t** voxels, int dims[3]) {
+
+    if (!model || !voxels || !dims) {
+        return fail(RECONS_INVALID_ARGUMENT, "model, voxels and dims must be set");
+    }
+    if (!model->result) {
+        return fail(RECONS_INVALID_STATE, "model has not been run");
+    }
+
+    const auto& space = model->result->space;
+    *voxels = reinterpret_cast<const uint8_t*>(space.data());
+    dims[0] = static_cast<int>(space.dimension(0));
+    dims[1] = static_cast<int>(space.dimension(1));
+    dims[2] = static_cast<int>(space.dimension(2));
+    return RECONS_OK;
+}
+
+recons_status recons_model_cubes(const recons_model* model,
+    const float** centers, size_t* count) {
+
+    if (!model || !centers || !count) {
+        return fail(RECONS_INVALID_ARGUMENT, "model, centers and count must be set");
+    }
+    if (!model->result) {
+        return fail(RECONS_INVALID_STATE, "model has not been run");
+    }
+
+    const auto& cubes = model->result->cubes;
+    *centers = reinterpret_cast<const float*>(cubes.data());
+    *count = cubes.size();
+    return RECONS_OK;
+}
+
+recons_status recons_model_cube_dimensions(const recons_model* model,
+    const float** dimensions) {
+
+    if (!model || !dimensions) {
+        return fail(RECONS_INVALID_ARGUMENT, "model and dimensions must be set");
+    }
+    if (!model->result) {
+        return fail(RECONS_INVALID_STATE, "model has not been run");
+    }
+
+    *dimensions = &model->result->cube_dimensions.x;
+    return RECONS_OK;
+}
+
+recons_status recons_model_bounds(const recons_model* model, const float** bounds) {
+    if (!model || !bounds) {
+        return fail(RECONS_INVALID_ARGUMENT, "model and bounds must be set");
+    }
+    if (!model->result) {
+        return fail(RECONS_INVALID_STATE, "model has not been run");
+    }
+
+    *bounds = model->result->bounds.data();
+    return RECONS_OK;
+}
+
+}
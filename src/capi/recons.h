@@ -0,0 +1,107 @@
+#ifndef RECONS_H
+#define RECONS_H
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * C interface of recons_lib, built as the recons_c shared library.
+ *
+ * Usage: create a model, add one view per silhouette, run it, then
+ * read the results. Every returned pointer aliases the model's own
+ * storage (no copies) and stays valid until the next successful
+ * recons_model_run() or recons_model_destroy() on that model.
+ * A model handle must not be used from several threads at once.
+ */
+
+/*
+ * Bumped on any incompatible change of the functions or types below,
+ * together with the SOVERSION of recons_c (librecons_c.so.1).
+ */
+#define RECONS_ABI_VERSION 1
+
+#if defined(_WIN32)
+#  if defined(RECONS_C_BUILD)
+#    define RECONS_API __declspec(dllexport)
+#  else
+#    define RECONS_API __declspec(dllimport)
+#  endif
+#else
+#  define RECONS_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct recons_model recons_model;
+
+typedef enum recons_status {
+    RECONS_OK = 0,
+    RECONS_INVALID_ARGUMENT = 1, /* null or out of range parameter */
+    RECONS_INVALID_STATE = 2,    /* results requested before a run */
+    RECONS_FAILURE = 3,          /* reconstruction or allocation error */
+} recons_status;
+
+typedef enum recons_component_policy {
+    RECONS_KEEP_ALL = 0,
+    RECONS_KEEP_LARGEST = 1,
+    RECONS_MIN_SIZE = 2,
+} recons_component_policy;
+
+/* Same fields as a view's camera.json */
+typedef struct recons_camera {
+    const char* name;
+    float origin[3];
+    float vx[3];
+    float vy[3];
+    float vz[3];
+} recons_camera;
+
+/* RECONS_ABI_VERSION the library was built with, compare at load time */
+RECONS_API int recons_abi_version(void);
+
+/* Message of the last failed call on this thread, never NULL */
+RECONS_API const char* recons_last_error(void);
+
+RECONS_API recons_status recons_model_create(int resolution, recons_model** model);
+RECONS_API void recons_model_destroy(recons_model* model);
+
+RECONS_API recons_status recons_model_set_component_filter(recons_model* model,
+    recons_component_policy policy, int min_size);
+
+/*
+ * Adds a view from an 8-bit grayscale image: rows top-down, `stride`
+ * bytes apart; 255 is background (the white of plane.bmp) and any
+ * other value is object. The pixels are not retained after the call.
+ */
+RECONS_API recons_status recons_model_add_view(recons_model* model,
+    const recons_camera* camera, const uint8_t* pixels,
+    int width, int height, size_t stride);
+
+/* Carves the voxel grid and generates the surface cubes */
+RECONS_API recons_status recons_model_run(recons_model* model);
+
+/*
+ * Occupancy grid, one byte (0 or 1) per voxel, x fastest:
+ * voxel (x, y, z) is voxels[x + dims[0] * (y + dims[1] * z)].
+ */
+RECONS_API recons_status recons_model_grid(const recons_model* model,
+    const uint8_t** voxels, int dims[3]);
+
+/* Surface cube centers as packed x, y, z floats */
+RECONS_API recons_status recons_model_cubes(const recons_model* model,
+    const float** centers, size_t* count);
+
+/* Size of every cube as x, y, z floats */
+RECONS_API recons_status recons_model_cube_dimensions(const recons_model* model,
+    const float** dimensions);
+
+/* min x, max x, min y, max y, min z, max z */
+RECONS_API recons_status recons_model_bounds(const recons_model* model,
+    const float** bounds);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RECONS_H */